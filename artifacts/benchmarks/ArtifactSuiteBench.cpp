@@ -0,0 +1,417 @@
+/* =============================================================================
+ * PROJECT:      ABCU Advising Assistant
+ * TOOL:         Cross-Artifact Benchmark Suite
+ *
+ * DESCRIPTION:  Times the same catalog operations in all four artifacts, so a
+ *               regression in one HashTable shows up next to the others:
+ *
+ *                 original          unordered_map, loadData(csv)
+ *                 enhancement1      unordered_map behind exceptions
+ *                 enhancement2      manual chained table, loadData(csv)
+ *                 enhancement3      arena table loaded from SQLite
+ *                 enhancement3-csv  the same table through loadCsv
+ *
+ *               Operations, each repeated until SECONDS of timed work:
+ *
+ *                 load         rows into a fresh table (op = one row)
+ *                 lookup_hit   stored codes (op = one lookup)
+ *                 lookup_miss  codes never stored (op = one lookup)
+ *                 list         the menu's sorted listing (op = one row)
+ *                 reload       rows into the already loaded table (op = one row)
+ *
+ *               Each version uses its own API, as its menu does: the original
+ *               can only look a course up by printing it, enhancements 1-2
+ *               copy it out with getCourse (a miss throws), enhancement 3
+ *               calls findCourse. Standard output is /dev/null while timing.
+ *
+ *               Catalogs are Program_Input.csv tiled to each size: copy k
+ *               adds 1000k to every course number, prerequisites included,
+ *               so 23 rows is the original file. Every (version, size) cell
+ *               runs in its own child process, so peak RSS is that cell's.
+ *               Allocations count operator new calls; SQLite's own mallocs
+ *               are not included.
+ *
+ *               Results go to standard output as CSV:
+ *                 version,rows,operation,ops,ns_per_op,allocs_per_op,peak_rss_kib
+ *
+ * BUILD:        g++ -std=c++17 -O2 -pthread -o ArtifactSuiteBench \
+ *                   ArtifactSuiteBench.cpp -lsqlite3
+ *
+ * USAGE:        ArtifactSuiteBench [--sizes N,N,...] [--versions NAME,...]
+ *                   [--seconds S] [--catalog FILE.csv] > results.csv
+ * =============================================================================
+ */
+
+
+
+
+// ============================================================================
+// IMPORTS
+// ----------------------------------------------------------------------------
+#define ADVISING_ASSISTANT_NO_MAIN
+#define ADVISING_COUNT_ALLOCATIONS      // allocs_per_op column
+#include "../enhancement3/AdvisingAssistant.cpp"
+#include <iomanip>          // Fixed-point CSV columns.
+#include <cctype>           // Included up front so the artifacts' own copy is a no-op.
+#include <sys/resource.h>   // Peak RSS of each child process.
+#include <sys/wait.h>
+
+// The earlier artifacts are whole programs with clashing names, so each is
+// compiled into its own namespace. Their main() becomes an ordinary
+// function there and is never called.
+namespace original {
+#include "../original/AdvisingAssistant.cpp"
+}
+namespace enhancement1 {
+#include "../enhancement1/AdvisingAssistant.cpp"
+}
+namespace enhancement2 {
+#include "../enhancement2/AdvisingAssistant.cpp"
+}
+// ============================================================================
+
+
+
+// ============================================================================
+// BENCHMARK: Versions Under Test
+// ----------------------------------------------------------------------------
+
+// Files one catalog size is available as.
+struct CatalogFiles {
+    string csv;
+    string db;          // Empty unless enhancement3 is selected
+};
+
+// Keeps lookup results alive so the optimizer cannot drop the lookups.
+size_t lookupSink = 0;
+
+struct OriginalVersion {
+    original::HashTable table;
+
+    void load(const CatalogFiles& files) {
+        if (!table.loadData(files.csv)) throw runtime_error("Could not open " + files.csv);
+    }
+    void lookup(const string& code) { table.printCourse(code); }
+    void list() { table.printCourseList(); }
+};
+
+// Enhancements 1 and 2 share an interface: getCourse, and a listing that
+// looks every sorted code up again, exactly as their menus do.
+template <typename Table>
+struct GetCourseVersion {
+    Table table;
+
+    void load(const CatalogFiles& files) { table.loadData(files.csv); }
+    void lookup(const string& code) {
+        try {
+            lookupSink += table.getCourse(code).getTitle().size();
+        }
+        catch (const runtime_error&) {
+            ++lookupSink;
+        }
+    }
+    void list() {
+        for (const auto& c : table.getSortedCourseCodes()) {
+            auto course = table.getCourse(c);
+            cout << course.getCode() << ": " << course.getTitle() << endl;
+        }
+    }
+};
+
+// Enhancement 3 with either loader; the connection lives as long as the
+// version, as it does across menu reloads.
+struct Enhancement3Version {
+    static bool fromCsv;
+    HashTable table;
+    unique_ptr<Database> database;
+
+    void load(const CatalogFiles& files) {
+        if (fromCsv) {
+            table.loadCsv(files.csv);
+            return;
+        }
+        if (!database) {
+            DatabaseOptions options;
+            options.path = files.db;
+            database.reset(new Database(options));
+        }
+        table.loadData(*database);
+    }
+    void lookup(const string& code) { lookupSink += table.findCourse(code) != nullptr; }
+    void list() {
+        OutputBuffer out;
+        for (uint32_t id : table.sortedCourseIds()) {
+            const Node* node = table.nodeOf(id);
+            out << node->code << ": " << node->title << '\n';
+        }
+        out.flush();
+    }
+};
+bool Enhancement3Version::fromCsv = false;
+
+const char* const VERSION_NAMES[] = {
+    "original", "enhancement1", "enhancement2", "enhancement3", "enhancement3-csv"
+};
+// ============================================================================
+
+
+
+// ============================================================================
+// BENCHMARK: Timing Harness
+// ----------------------------------------------------------------------------
+
+// Lookup queries per timed pass; larger catalogs are sampled evenly.
+const size_t LOOKUP_QUERIES = 100000;
+
+struct OpResult {
+    string operation;
+    size_t ops = 0;
+    double seconds = 0;
+    size_t allocations = 0;
+};
+
+// Calls prepare() untimed, then run() timed, until minSeconds of run()
+// time has passed. run() returns the ops it performed.
+template <typename Prepare, typename Run>
+OpResult timeOperation(const string& operation, double minSeconds, Prepare prepare, Run run) {
+    OpResult result;
+    result.operation = operation;
+    do {
+        prepare();
+        size_t allocationsBefore = threadAllocations;
+        auto start = chrono::steady_clock::now();
+        result.ops += run();
+        result.seconds += chrono::duration<double>(chrono::steady_clock::now() - start).count();
+        result.allocations += threadAllocations - allocationsBefore;
+    } while (result.seconds < minSeconds);
+    return result;
+}
+
+// Codes of about LOOKUP_QUERIES rows spread over the file, and a miss
+// query for each (the code with a suffix no catalog row uses).
+void sampleQueries(const string& csv, size_t rows, vector<string>& hits, vector<string>& misses) {
+    ifstream file(csv);
+    size_t stride = max<size_t>(rows / LOOKUP_QUERIES, 1);
+    string line;
+    for (size_t i = 0; getline(file, line); ++i) {
+        if (i % stride != 0) continue;
+        string code = line.substr(0, line.find(','));
+        hits.push_back(code);
+        misses.push_back(code + "X");
+    }
+}
+
+template <typename Version>
+vector<OpResult> runOperations(const CatalogFiles& files, size_t rows, double minSeconds) {
+    vector<string> hits, misses;
+    sampleQueries(files.csv, rows, hits, misses);
+    auto none = [] {};
+    vector<OpResult> results;
+
+    unique_ptr<Version> fresh;
+    results.push_back(timeOperation("load", minSeconds, [&] { fresh.reset(new Version()); },
+                                    [&] { fresh->load(files); return rows; }));
+
+    Version& version = *fresh;
+    for (auto* queries : { &hits, &misses }) {
+        results.push_back(timeOperation(queries == &hits ? "lookup_hit" : "lookup_miss", minSeconds, none, [&] {
+            for (const string& code : *queries) version.lookup(code);
+            return queries->size();
+        }));
+    }
+    results.push_back(timeOperation("list", minSeconds, none, [&] { version.list(); return rows; }));
+    results.push_back(timeOperation("reload", minSeconds, none, [&] { version.load(files); return rows; }));
+    return results;
+}
+
+vector<OpResult> runVersion(const string& name, const CatalogFiles& files, size_t rows, double minSeconds) {
+    if (name == "original") return runOperations<OriginalVersion>(files, rows, minSeconds);
+    if (name == "enhancement1") {
+        return runOperations<GetCourseVersion<enhancement1::HashTable>>(files, rows, minSeconds);
+    }
+    if (name == "enhancement2") {
+        return runOperations<GetCourseVersion<enhancement2::HashTable>>(files, rows, minSeconds);
+    }
+    Enhancement3Version::fromCsv = (name == "enhancement3-csv");
+    return runOperations<Enhancement3Version>(files, rows, minSeconds);
+}
+
+// Runs one (version, size) cell in a child process with standard output on
+// /dev/null, and prints its rows as CSV with the child's peak RSS. Returns
+// false if the child failed.
+bool runCell(const string& name, const CatalogFiles& files, size_t rows, double minSeconds) {
+    int fds[2];
+    if (pipe(fds) != 0) throw runtime_error("pipe failed");
+    cout.flush();
+    pid_t pid = fork();
+    if (pid < 0) throw runtime_error("fork failed");
+
+    if (pid == 0) {
+        close(fds[0]);
+        int devNull = open("/dev/null", O_WRONLY);
+        if (devNull >= 0) dup2(devNull, STDOUT_FILENO);
+        string report;
+        try {
+            for (const OpResult& r : runVersion(name, files, rows, minSeconds)) {
+                ostringstream line;
+                line << name << ',' << rows << ',' << r.operation << ',' << r.ops << ','
+                     << fixed << setprecision(1) << r.seconds * 1e9 / r.ops << ','
+                     << setprecision(3) << static_cast<double>(r.allocations) / r.ops << '\n';
+                report += line.str();
+            }
+        }
+        catch (const exception& e) {
+            report = string("error,") + e.what() + '\n';
+        }
+        cout.flush();
+        if (write(fds[1], report.data(), report.size()) != static_cast<ssize_t>(report.size())) _exit(1);
+        _exit(0);
+    }
+
+    close(fds[1]);
+    string report;
+    char chunk[4096];
+    ssize_t got;
+    while ((got = read(fds[0], chunk, sizeof(chunk))) > 0) report.append(chunk, static_cast<size_t>(got));
+    close(fds[0]);
+    int status = 0;
+    struct rusage usage {};
+    wait4(pid, &status, 0, &usage);
+
+    if (!WIFEXITED(status) || WEXITSTATUS(status) != 0 || report.empty() || report.compare(0, 6, "error,") == 0) {
+        cerr << name << " at " << rows << " rows failed: "
+             << (report.compare(0, 6, "error,") == 0 ? report.substr(6) : "child exited abnormally\n");
+        return false;
+    }
+    istringstream lines(report);
+    string line;
+    while (getline(lines, line)) cout << line << ',' << usage.ru_maxrss << '\n';
+    cout.flush();
+    return true;
+}
+// ============================================================================
+
+
+
+// ============================================================================
+// BENCHMARK: Catalog Files
+// ----------------------------------------------------------------------------
+
+// Writes Program_Input.csv tiled to 'rows' rows. Copy k adds 1000k to each
+// course number (every code is letters then a number below 1000), so codes
+// and prerequisite references stay unique per copy; a final partial copy
+// leaves a few references dangling, as real catalogs do.
+void writeTiledCatalog(const string& seedPath, const string& path, size_t rows) {
+    ifstream seed(seedPath);
+    vector<string> lines;
+    string line;
+    while (getline(seed, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        if (!line.empty()) lines.push_back(line);
+    }
+    if (lines.empty()) throw runtime_error("Could not read " + seedPath);
+
+    auto shift = [](const string& code, size_t copy) {
+        size_t digits = code.find_first_of("0123456789");
+        if (copy == 0 || digits == string::npos) return code;
+        return code.substr(0, digits) + to_string(stoul(code.substr(digits)) + 1000 * copy);
+    };
+
+    ofstream out(path, ios::binary);
+    for (size_t row = 0; row < rows; ++row) {
+        size_t copy = row / lines.size();
+        istringstream fields(lines[row % lines.size()]);
+        string field;
+        for (size_t column = 0; getline(fields, field, ','); ++column) {
+            if (column > 0) out << ',';
+            out << (column == 1 || field.empty() ? field : shift(field, copy));
+        }
+        out << '\n';
+    }
+    if (!out) throw runtime_error("Could not write " + path);
+}
+
+size_t countRows(const string& path) {
+    ifstream file(path);
+    if (!file) throw runtime_error("Could not open " + path);
+    size_t rows = 0;
+    string line;
+    while (getline(file, line)) ++rows;
+    return rows;
+}
+
+vector<string> splitList(const string& text) {
+    vector<string> items;
+    istringstream in(text);
+    string item;
+    while (getline(in, item, ',')) {
+        if (!item.empty()) items.push_back(item);
+    }
+    return items;
+}
+// ============================================================================
+
+
+
+int main(int argc, char* argv[]) {
+    vector<size_t> sizes = { 23, 1000, 10000, 100000, 1000000, 10000000 };
+    vector<string> versions(begin(VERSION_NAMES), end(VERSION_NAMES));
+    double minSeconds = 0.5;
+    string catalog;
+    const string seedPath = "../enhancement3/Program_Input.csv";
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+            string value = argv[++i];
+            if (arg == "--sizes") {
+                sizes.clear();
+                for (const string& size : splitList(value)) sizes.push_back(stoul(size));
+            }
+            else if (arg == "--versions") versions = splitList(value);
+            else if (arg == "--seconds") minSeconds = stod(value);
+            else if (arg == "--catalog") catalog = value;
+            else throw invalid_argument("Unknown option " + arg);
+        }
+        for (const string& name : versions) {
+            if (find(begin(VERSION_NAMES), end(VERSION_NAMES), name) == end(VERSION_NAMES)) {
+                throw invalid_argument("Unknown version " + name);
+            }
+        }
+        if (!catalog.empty()) sizes = { countRows(catalog) };
+        bool needDatabase = find(versions.begin(), versions.end(), "enhancement3") != versions.end();
+
+        cout << "version,rows,operation,ops,ns_per_op,allocs_per_op,peak_rss_kib\n";
+        bool allPassed = true;
+        for (size_t rows : sizes) {
+            CatalogFiles files;
+            files.csv = catalog.empty() ? "ArtifactSuiteBench." + to_string(rows) + ".csv" : catalog;
+            if (catalog.empty()) writeTiledCatalog(seedPath, files.csv, rows);
+            if (needDatabase) {
+                files.db = "ArtifactSuiteBench." + to_string(rows) + ".db";
+                remove(files.db.c_str());
+                cerr << "Importing " << rows << " rows into " << files.db << endl;
+                DatabaseOptions options;
+                options.path = files.db;
+                options.queryOnly = false;
+                Database database(options);
+                importCatalogCsv(database, files.csv);
+            }
+
+            for (const string& name : versions) {
+                cerr << "Running " << name << " at " << rows << " rows" << endl;
+                allPassed = runCell(name, files, rows, minSeconds) && allPassed;
+            }
+
+            if (catalog.empty()) remove(files.csv.c_str());
+            if (needDatabase) remove(files.db.c_str());
+        }
+        return allPassed ? 0 : 1;
+    }
+    catch (const exception& e) {
+        cerr << "SYSTEM ERROR: " << e.what() << endl;
+        return 1;
+    }
+}
+// ============================================================================
@@ -0,0 +1,621 @@
+/* =============================================================================
+ * PROJECT:      ABCU Advising Assistant
+ * TOOL:         Synthetic Catalog and Transcript Generator
+ *
+ * DESCRIPTION:  Writes catalogs of any size for scale testing, as a CSV file
+ *               in Program_Input.csv form and/or a SQLite file with the
+ *               original courses table (run AdvisingAssistant --migrate on it
+ *               for the current schema), plus transcripts in the
+ *               "studentId,CODE,CODE,..." form --audit reads.
+ *
+ *               Courses are spread over departments and levels; a course at
+ *               level L has 1..FAN_IN prerequisites from levels below it, so
+ *               prerequisite chains are at most DEPTH long and the graph has
+ *               no cycles. Only level 1 has no prerequisites, and it holds
+ *               an OPEN fraction of the courses (default 0.05); the other
+ *               levels share the rest in proportion to their weights. Codes are the department prefix, the level digit
+ *               and a sequence number (CSCI101, MATH204, ... CSCI1042 once a
+ *               level needs more digits). A DUPLICATES fraction of courses
+ *               get a second, later row with a revised title; a DANGLING
+ *               fraction of prerequisite references name a course that
+ *               does not exist. The SQLite file keeps the first row of a
+ *               repeated code, as every loader does.
+ *
+ *               Each transcript is a student's completed courses in an order
+ *               they could have been taken: every course appears after all
+ *               of its prerequisites, and courses that depend on a dangling
+ *               reference are never completed.
+ *
+ *               Output depends only on the options: the same seed gives
+ *               byte-identical files on every platform. The catalog and the
+ *               transcripts draw from separate streams, so changing the
+ *               student options leaves the catalog unchanged.
+ *
+ * BUILD:        g++ -std=c++17 -O2 -pthread -o CatalogGenerator \
+ *                   CatalogGenerator.cpp -lsqlite3
+ *
+ * USAGE:        CatalogGenerator --courses N [--seed S] [--departments D]
+ *                   [--depth L | --levels W1,W2,...] [--open RATE]
+ *                   [--fan-in K] [--duplicates RATE] [--dangling RATE]
+ *                   [--csv FILE] [--db FILE]
+ *                   [--students N --transcripts FILE [--targets T]
+ *                    [--max-completed M]]
+ * =============================================================================
+ */
+
+
+
+
+// ============================================================================
+// IMPORTS
+// ----------------------------------------------------------------------------
+#define ADVISING_ASSISTANT_NO_MAIN
+#include "../enhancement3/AdvisingAssistant.cpp"
+// ============================================================================
+
+
+
+// ============================================================================
+// GENERATOR: Deterministic Random Numbers
+// ----------------------------------------------------------------------------
+
+// SplitMix64. The standard distributions are implementation-defined, so
+// every draw is derived here to keep output identical across platforms.
+class SplitMix64 {
+private:
+    uint64_t state;
+
+    // High 64 bits of a * b, in 32-bit halves so no 128-bit type is needed.
+    static uint64_t mulHigh(uint64_t a, uint64_t b) {
+        uint64_t aLow = a & 0xFFFFFFFFull, aHigh = a >> 32;
+        uint64_t bLow = b & 0xFFFFFFFFull, bHigh = b >> 32;
+        uint64_t cross1 = aHigh * bLow, cross2 = aLow * bHigh;
+        uint64_t carry = ((aLow * bLow >> 32) + (cross1 & 0xFFFFFFFFull) + (cross2 & 0xFFFFFFFFull)) >> 32;
+        return aHigh * bHigh + (cross1 >> 32) + (cross2 >> 32) + carry;
+    }
+
+public:
+    explicit SplitMix64(uint64_t seed) : state(seed) {}
+
+    uint64_t next() {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // Uniform in [0, bound); bound must be non-zero. Lemire's multiply-shift:
+    // the high half of next() * bound, redrawing the few low halves that
+    // would make some results more likely than others.
+    uint64_t below(uint64_t bound) {
+        uint64_t draw = next();
+        uint64_t low = draw * bound;
+        if (low < bound) {
+            uint64_t threshold = (0 - bound) % bound;
+            while (low < threshold) {
+                draw = next();
+                low = draw * bound;
+            }
+        }
+        return mulHigh(draw, bound);
+    }
+
+    // Uniform in [0, 1).
+    double unit() { return static_cast<double>(next() >> 11) * (1.0 / 9007199254740992.0); }
+
+    bool chance(double probability) { return unit() < probability; }
+
+    // Index drawn in proportion to weights (at least one positive).
+    size_t weighted(const vector<double>& weights, double total) {
+        double pick = unit() * total;
+        for (size_t i = 0; i + 1 < weights.size(); ++i) {
+            if (pick < weights[i]) return i;
+            pick -= weights[i];
+        }
+        return weights.size() - 1;
+    }
+};
+// ============================================================================
+
+
+
+// ============================================================================
+// GENERATOR: Catalog Model
+// ----------------------------------------------------------------------------
+
+struct CatalogSpec {
+    size_t courses = 1000;
+    uint64_t seed = 1;
+    size_t departments = 8;
+    vector<double> levelWeights = { 4, 3, 2, 1 };   // Level 1 first; size is the depth
+    double openRate = 0.05;                         // Share at level 1; replaces its weight
+    size_t fanIn = 3;
+    double duplicateRate = 0.01;
+    double danglingRate = 0.005;
+};
+
+// A prerequisite reference. Dangling ones have no course and name a code
+// past the end of their department and level.
+struct PrereqRef {
+    uint32_t course;            // NO_COURSE when dangling
+    uint32_t department;
+    uint32_t level;
+    uint32_t number;
+};
+
+struct GeneratedCourse {
+    uint32_t department;
+    uint32_t level;             // 1-based
+    uint32_t number;            // 1-based within department and level
+    uint32_t firstPrereq;       // Into CatalogModel::prereqs
+    uint32_t prereqCount;
+    uint32_t title;             // Topic index
+};
+
+// A department with a real-looking prefix and name; past the list,
+// prefixes are synthesized (DAAA, DAAB, ...).
+struct Department {
+    string prefix;
+    string name;
+};
+
+const Department KNOWN_DEPARTMENTS[] = {
+    { "CSCI", "Computer Science" }, { "MATH", "Mathematics" }, { "PHYS", "Physics" },
+    { "CHEM", "Chemistry" }, { "BIOL", "Biology" }, { "ENGL", "English" },
+    { "HIST", "History" }, { "ECON", "Economics" }, { "PSYC", "Psychology" },
+    { "STAT", "Statistics" }, { "PHIL", "Philosophy" }, { "ARTS", "Fine Arts" },
+    { "MUSC", "Music" }, { "GEOL", "Geology" }, { "POLS", "Political Science" },
+    { "SOCI", "Sociology" }
+};
+
+const char* const LEVEL_WORDS[] = {
+    "Introduction to", "Intermediate", "Advanced", "Topics in", "Seminar in",
+    "Research in", "Graduate", "Doctoral", "Special Studies in"
+};
+
+const char* const TOPICS[] = {
+    "Foundations", "Methods", "Theory", "Systems", "Analysis", "Design", "Practice",
+    "Modeling", "Applications", "Structures", "Computation", "Communication",
+    "Ethics", "Data", "History", "Laboratory", "Networks", "Optimization"
+};
+
+class CatalogModel {
+private:
+    CatalogSpec spec;
+    vector<Department> departments;
+    vector<GeneratedCourse> courses;
+    vector<PrereqRef> prereqs;
+    vector<vector<uint32_t>> buckets;       // department * depth + level - 1 -> courses
+    vector<uint32_t> levelOne;              // Every level 1 course, in id order
+    vector<pair<uint32_t, bool>> rows;      // Course, and whether it is the repeat row
+    int numberWidth = 2;
+    size_t danglingCount = 0;
+
+    vector<uint32_t>& bucket(uint32_t department, uint32_t level) {
+        return buckets[department * depth() + level - 1];
+    }
+
+    static string synthesizedPrefix(size_t index) {
+        string prefix = "DAAA";
+        for (size_t i = 3; i > 0 && index > 0; --i, index /= 26) prefix[i] = static_cast<char>('A' + index % 26);
+        return prefix;
+    }
+
+    // One reference for a course at 'level' in 'department': usually the
+    // same department and the level just below, else anywhere lower.
+    PrereqRef pickPrereq(SplitMix64& rng, uint32_t department, uint32_t level) {
+        uint32_t prereqDepartment = rng.chance(0.75) ? department
+                                                     : static_cast<uint32_t>(rng.below(departments.size()));
+        uint32_t prereqLevel = rng.chance(0.7) ? level - 1 : 1 + static_cast<uint32_t>(rng.below(level - 1));
+        vector<uint32_t>& candidates = bucket(prereqDepartment, prereqLevel);
+
+        if (rng.chance(spec.danglingRate)) {
+            uint32_t past = static_cast<uint32_t>(candidates.size() + 1 + rng.below(candidates.size() + 9));
+            return PrereqRef{ NO_COURSE, prereqDepartment, prereqLevel, past };
+        }
+        if (candidates.empty()) return PrereqRef{ NO_COURSE, 0, 0, 0 };
+        uint32_t course = candidates[rng.below(candidates.size())];
+        return PrereqRef{ course, prereqDepartment, prereqLevel, courses[course].number };
+    }
+
+public:
+    explicit CatalogModel(const CatalogSpec& spec) : spec(spec) {
+        if (spec.courses == 0 || spec.departments == 0) throw invalid_argument("Need at least one course and department.");
+        if (spec.departments > 26 * 26 * 26) throw invalid_argument("At most 17576 departments.");
+        if (spec.courses >= NO_COURSE) throw invalid_argument("Too many courses.");
+        if (spec.levelWeights.empty() || spec.levelWeights.size() > 9) throw invalid_argument("Depth must be 1 to 9.");
+        if (!(spec.openRate > 0 && spec.openRate <= 1)) throw invalid_argument("Open rate must be above 0 and at most 1.");
+        SplitMix64 rng(spec.seed);
+
+        for (size_t d = 0; d < spec.departments; ++d) {
+            if (d < sizeof(KNOWN_DEPARTMENTS) / sizeof(KNOWN_DEPARTMENTS[0])) departments.push_back(KNOWN_DEPARTMENTS[d]);
+            else departments.push_back(Department{ synthesizedPrefix(d), "Studies in " + synthesizedPrefix(d) });
+        }
+
+        // Level 1 gets the open share and the rest split the remainder by
+        // weight. The first course is always at level 1, so every later
+        // course has somewhere to draw a prerequisite from.
+        vector<double> weights(depth(), 0.0);
+        double upperTotal = 0;
+        for (size_t level = 1; level < depth(); ++level) upperTotal += spec.levelWeights[level];
+        if (depth() > 1 && spec.openRate < 1 && upperTotal <= 0) {
+            throw invalid_argument("Levels above 1 need a positive weight.");
+        }
+        weights[0] = spec.openRate;
+        for (size_t level = 1; level < depth(); ++level) {
+            weights[level] = (1 - spec.openRate) * spec.levelWeights[level] / upperTotal;
+        }
+
+        // Place every course, then number each department-level bucket.
+        buckets.assign(spec.departments * depth(), vector<uint32_t>());
+        courses.resize(spec.courses);
+        for (uint32_t i = 0; i < courses.size(); ++i) {
+            GeneratedCourse& course = courses[i];
+            course.department = static_cast<uint32_t>(rng.below(spec.departments));
+            course.level = i == 0 ? 1 : static_cast<uint32_t>(1 + rng.weighted(weights, 1.0));
+            if (course.level == 1) levelOne.push_back(i);
+            course.title = static_cast<uint32_t>(rng.below(sizeof(TOPICS) / sizeof(TOPICS[0])));
+            vector<uint32_t>& members = bucket(course.department, course.level);
+            members.push_back(i);
+            course.number = static_cast<uint32_t>(members.size());
+        }
+
+        // Dangling numbers go up to twice a bucket's size plus ten; leave room.
+        size_t largest = 0;
+        for (const vector<uint32_t>& members : buckets) largest = max(largest, members.size());
+        for (size_t limit = 100; limit <= 2 * largest + 10; limit *= 10) ++numberWidth;
+
+        // Prerequisites come only from lower levels, so the graph is acyclic.
+        for (GeneratedCourse& course : courses) {
+            course.firstPrereq = static_cast<uint32_t>(prereqs.size());
+            course.prereqCount = 0;
+            if (course.level == 1 || spec.fanIn == 0) continue;
+            size_t wanted = 1 + rng.below(spec.fanIn);
+            for (size_t k = 0; k < wanted; ++k) {
+                PrereqRef ref = pickPrereq(rng, course.department, course.level);
+                if (ref.level == 0) continue;
+                bool repeated = false;
+                for (uint32_t j = course.firstPrereq; j < prereqs.size(); ++j) {
+                    const PrereqRef& other = prereqs[j];
+                    repeated = repeated || (other.department == ref.department && other.level == ref.level
+                                            && other.number == ref.number);
+                }
+                if (repeated) continue;
+                danglingCount += ref.course == NO_COURSE;
+                prereqs.push_back(ref);
+                ++course.prereqCount;
+            }
+
+            // Every pick hit an empty bucket: fall back to any level 1
+            // course, so the open share stays what was asked for.
+            if (course.prereqCount == 0) {
+                uint32_t fallback = levelOne[rng.below(levelOne.size())];
+                const GeneratedCourse& first = courses[fallback];
+                prereqs.push_back(PrereqRef{ fallback, first.department, 1, first.number });
+                ++course.prereqCount;
+            }
+        }
+
+        // Rows in random order; a repeat sorts somewhere after its original.
+        vector<pair<double, uint32_t>> keyed;
+        vector<pair<double, uint32_t>> repeats;
+        keyed.reserve(courses.size());
+        for (uint32_t i = 0; i < courses.size(); ++i) {
+            double key = rng.unit();
+            keyed.emplace_back(key, i);
+            if (rng.chance(spec.duplicateRate)) repeats.emplace_back(key + (1 - key) * rng.unit(), i);
+        }
+        sort(keyed.begin(), keyed.end());
+        sort(repeats.begin(), repeats.end());
+        rows.reserve(keyed.size() + repeats.size());
+        size_t r = 0;
+        for (const auto& entry : keyed) {
+            while (r < repeats.size() && repeats[r] < entry) rows.emplace_back(repeats[r++].second, true);
+            rows.emplace_back(entry.second, false);
+        }
+        while (r < repeats.size()) rows.emplace_back(repeats[r++].second, true);
+    }
+
+    size_t depth() const { return spec.levelWeights.size(); }
+    size_t courseCount() const { return courses.size(); }
+    size_t rowCount() const { return rows.size(); }
+    size_t edgeCount() const { return prereqs.size(); }
+    size_t danglingRefs() const { return danglingCount; }
+    size_t departmentCount() const { return departments.size(); }
+
+    const GeneratedCourse& course(uint32_t id) const { return courses[id]; }
+    const PrereqRef& prereq(size_t index) const { return prereqs[index]; }
+    const vector<uint32_t>& members(uint32_t department, uint32_t level) const {
+        return buckets[department * depth() + level - 1];
+    }
+
+    void appendCode(string& out, uint32_t department, uint32_t level, uint32_t number) const {
+        out += departments[department].prefix;
+        out += static_cast<char>('0' + level);
+        string digits = to_string(number);
+        out.append(numberWidth - digits.size(), '0');
+        out += digits;
+    }
+
+    void appendCode(string& out, uint32_t id) const {
+        appendCode(out, courses[id].department, courses[id].level, courses[id].number);
+    }
+
+    void appendTitle(string& out, uint32_t id, bool repeat) const {
+        const GeneratedCourse& c = courses[id];
+        out += LEVEL_WORDS[c.level - 1];
+        out += ' ';
+        out += departments[c.department].name;
+        out += ' ';
+        out += TOPICS[c.title];
+        if (repeat) out += " (Revised)";
+    }
+
+    // Comma-separated prerequisite codes; CSV rows also need one before the first.
+    void appendPrereqs(string& out, uint32_t id, bool leadingComma) const {
+        const GeneratedCourse& c = courses[id];
+        for (uint32_t k = 0; k < c.prereqCount; ++k) {
+            if (k > 0 || leadingComma) out += ',';
+            const PrereqRef& ref = prereqs[c.firstPrereq + k];
+            appendCode(out, ref.department, ref.level, ref.number);
+        }
+    }
+
+    // Program_Input.csv form: CODE,Title,PREREQ,PREREQ...
+    void writeCsv(const string& path) const {
+        ofstream out(path, ios::binary);
+        if (!out.is_open()) throw runtime_error("Could not open file: " + path);
+        string line;
+        for (const auto& row : rows) {
+            line.clear();
+            appendCode(line, row.first);
+            line += ',';
+            appendTitle(line, row.first, row.second);
+            appendPrereqs(line, row.first, true);
+            line += '\n';
+            out << line;
+        }
+        if (!out) throw runtime_error("Failed writing: " + path);
+    }
+
+    // The original courses table, prerequisites comma-joined, written in
+    // batched transactions. Replaces any existing file at path.
+    void writeDatabase(const string& path) const {
+        remove(path.c_str());
+        DatabaseOptions options;
+        options.path = path;
+        options.queryOnly = false;
+        options.journalMode = "OFF";
+        Database database(options);
+        database.execute("PRAGMA synchronous=OFF;");
+        database.execute(
+            "CREATE TABLE courses ("
+            "    code TEXT PRIMARY KEY COLLATE NOCASE,"
+            "    title TEXT NOT NULL,"
+            "    prerequisites TEXT"
+            ");");
+
+        string code, title, joined;
+        for (size_t first = 0; first < rows.size(); first += IMPORT_BATCH_ROWS) {
+            database.execute("BEGIN;");
+            for (size_t i = first; i < min(rows.size(), first + IMPORT_BATCH_ROWS); ++i) {
+                code.clear();
+                title.clear();
+                joined.clear();
+                appendCode(code, rows[i].first);
+                appendTitle(title, rows[i].first, rows[i].second);
+                appendPrereqs(joined, rows[i].first, false);
+                Statement insert = database.query("INSERT OR IGNORE INTO courses VALUES (?, ?, ?);");
+                insert.bind(1, code);
+                insert.bind(2, title);
+                insert.bind(3, joined);
+                insert.step();
+            }
+            database.execute("COMMIT;");
+        }
+        database.execute("PRAGMA journal_mode=DELETE;");
+    }
+};
+// ============================================================================
+
+
+
+// ============================================================================
+// GENERATOR: Student Transcripts
+// ----------------------------------------------------------------------------
+
+struct TranscriptSpec {
+    size_t students = 0;
+    size_t targets = 8;             // Courses a student sets out to take, at most
+    size_t maxCompleted = 48;       // Cap on a transcript, prerequisites included
+    uint64_t seed = 1;
+};
+
+// Completes courses with everything they need first. Marks are stamped
+// per student, so nothing is cleared between students.
+class TranscriptWriter {
+private:
+    const CatalogModel& catalog;
+    vector<uint32_t> mark;          // Student stamp that completed the course
+    uint32_t stamp = 0;
+    vector<uint32_t> completed;     // This student's courses, prerequisites first
+    vector<pair<uint32_t, uint32_t>> stack;
+
+    // Appends target and its unfinished prerequisites in post-order. Undoes
+    // everything on a dangling reference or if the transcript would exceed
+    // limit, and returns false.
+    bool complete(uint32_t target, size_t limit) {
+        size_t before = completed.size();
+        vector<uint32_t> entered;
+        auto fail = [&] {
+            for (uint32_t id : entered) mark[id] = 0;
+            completed.resize(before);
+            stack.clear();
+            return false;
+        };
+        if (mark[target] == stamp) return true;
+        mark[target] = stamp;
+        entered.push_back(target);
+        stack.emplace_back(target, 0);
+        while (!stack.empty()) {
+            auto& frame = stack.back();
+            const GeneratedCourse& course = catalog.course(frame.first);
+            if (frame.second < course.prereqCount) {
+                const PrereqRef& ref = catalog.prereq(course.firstPrereq + frame.second++);
+                if (ref.course == NO_COURSE) return fail();
+                if (mark[ref.course] == stamp) continue;
+                mark[ref.course] = stamp;
+                entered.push_back(ref.course);
+                stack.emplace_back(ref.course, 0);
+                continue;
+            }
+            completed.push_back(frame.first);
+            stack.pop_back();
+            if (completed.size() > limit) return fail();
+        }
+        return true;
+    }
+
+public:
+    explicit TranscriptWriter(const CatalogModel& catalog) : catalog(catalog), mark(catalog.courseCount(), 0) {}
+
+    // Students have a home department and a year (a level they have reached)
+    // and aim at a few courses up to that level, mostly in their department.
+    void write(const TranscriptSpec& spec, const string& path) {
+        ofstream out(path, ios::binary);
+        if (!out.is_open()) throw runtime_error("Could not open file: " + path);
+        SplitMix64 rng(spec.seed ^ 0x5DEECE66Dull);
+        int idWidth = max<int>(8, static_cast<int>(to_string(spec.students).size()));
+        string line;
+
+        for (size_t student = 1; student <= spec.students; ++student) {
+            if (++stamp == 0) {
+                fill(mark.begin(), mark.end(), 0);
+                stamp = 1;
+            }
+            completed.clear();
+            uint32_t home = static_cast<uint32_t>(rng.below(catalog.departmentCount()));
+            uint32_t year = static_cast<uint32_t>(1 + rng.below(catalog.depth()));
+            size_t targets = spec.targets == 0 ? 0 : 1 + rng.below(spec.targets);
+            for (size_t t = 0; t < targets; ++t) {
+                uint32_t department = rng.chance(0.6) ? home : static_cast<uint32_t>(rng.below(catalog.departmentCount()));
+                uint32_t level = static_cast<uint32_t>(1 + rng.below(year));
+                const vector<uint32_t>& candidates = catalog.members(department, level);
+                if (candidates.empty()) continue;
+                complete(candidates[rng.below(candidates.size())], spec.maxCompleted);
+            }
+
+            line = "S";
+            string digits = to_string(student);
+            line.append(idWidth - digits.size(), '0');
+            line += digits;
+            for (uint32_t id : completed) {
+                line += ',';
+                catalog.appendCode(line, id);
+            }
+            line += '\n';
+            out << line;
+        }
+        if (!out) throw runtime_error("Failed writing: " + path);
+    }
+};
+// ============================================================================
+
+
+
+vector<double> parseWeights(const string& text) {
+    vector<double> weights;
+    istringstream in(text);
+    string item;
+    while (getline(in, item, ',')) {
+        weights.push_back(stod(item));
+        if (weights.back() < 0) throw invalid_argument("Level weights must not be negative.");
+    }
+    return weights;
+}
+
+void printGeneratorUsage() {
+    cout << "Usage: CatalogGenerator --courses N [--seed S] [--departments D]\n"
+         << "           [--depth L | --levels W1,W2,...] [--open RATE]\n"
+         << "           [--fan-in K] [--duplicates RATE] [--dangling RATE]\n"
+         << "           [--csv FILE] [--db FILE]\n"
+         << "           [--students N --transcripts FILE [--targets T]\n"
+         << "            [--max-completed M]]" << endl;
+}
+
+int main(int argc, char* argv[]) {
+    CatalogSpec catalogSpec;
+    TranscriptSpec transcriptSpec;
+    string csvPath, dbPath, transcriptPath;
+    size_t depth = 0;
+    bool levelsGiven = false;
+
+    try {
+        for (int i = 1; i < argc; ++i) {
+            string arg = argv[i];
+            if (arg == "--help" || arg == "-h") {
+                printGeneratorUsage();
+                return 0;
+            }
+            if (i + 1 >= argc) throw invalid_argument("Missing value for " + arg);
+            string value = argv[++i];
+            if (arg == "--courses") catalogSpec.courses = stoul(value);
+            else if (arg == "--seed") catalogSpec.seed = stoull(value);
+            else if (arg == "--departments") catalogSpec.departments = stoul(value);
+            else if (arg == "--depth") depth = stoul(value);
+            else if (arg == "--levels") {
+                catalogSpec.levelWeights = parseWeights(value);
+                levelsGiven = true;
+            }
+            else if (arg == "--open") catalogSpec.openRate = stod(value);
+            else if (arg == "--fan-in") catalogSpec.fanIn = stoul(value);
+            else if (arg == "--duplicates") catalogSpec.duplicateRate = stod(value);
+            else if (arg == "--dangling") catalogSpec.danglingRate = stod(value);
+            else if (arg == "--csv") csvPath = value;
+            else if (arg == "--db") dbPath = value;
+            else if (arg == "--students") transcriptSpec.students = stoul(value);
+            else if (arg == "--transcripts") transcriptPath = value;
+            else if (arg == "--targets") transcriptSpec.targets = stoul(value);
+            else if (arg == "--max-completed") transcriptSpec.maxCompleted = stoul(value);
+            else throw invalid_argument("Unknown option " + arg);
+        }
+
+        // --depth alone gives descending weights (more intro than upper level).
+        if (depth != 0 && levelsGiven && catalogSpec.levelWeights.size() != depth) {
+            throw invalid_argument("--depth and the number of --levels weights differ.");
+        }
+        if (depth != 0 && !levelsGiven) {
+            if (depth > 9) throw invalid_argument("Depth must be 1 to 9.");
+            catalogSpec.levelWeights.clear();
+            for (size_t level = depth; level > 0; --level) catalogSpec.levelWeights.push_back(static_cast<double>(level));
+        }
+        if (csvPath.empty() && dbPath.empty() && transcriptPath.empty()) {
+            throw invalid_argument("Nothing to write: give --csv, --db or --transcripts.");
+        }
+        if (transcriptPath.empty() != (transcriptSpec.students == 0)) {
+            throw invalid_argument("--students and --transcripts go together.");
+        }
+        transcriptSpec.seed = catalogSpec.seed;
+
+        auto start = chrono::steady_clock::now();
+        CatalogModel catalog(catalogSpec);
+        if (!csvPath.empty()) catalog.writeCsv(csvPath);
+        if (!dbPath.empty()) catalog.writeDatabase(dbPath);
+        if (!transcriptPath.empty()) TranscriptWriter(catalog).write(transcriptSpec, transcriptPath);
+        double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+        cerr << catalog.courseCount() << " courses (" << catalog.rowCount() << " rows, "
+             << catalog.rowCount() - catalog.courseCount() << " repeated) in "
+             << catalog.departmentCount() << " departments over " << catalog.depth() << " levels; "
+             << catalog.edgeCount() << " prerequisite references, " << catalog.danglingRefs()
+             << " dangling";
+        if (transcriptSpec.students > 0) cerr << "; " << transcriptSpec.students << " transcripts";
+        cerr << " (" << seconds << " s)" << endl;
+    }
+    catch (const exception& e) {
+        cerr << "SYSTEM ERROR: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+// ============================================================================
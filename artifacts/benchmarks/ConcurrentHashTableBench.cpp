@@ -0,0 +1,290 @@
+/* =============================================================================
+ * PROJECT:      ABCU Advising Assistant
+ * TOOL:         Concurrent HashTable Stress Test and Read-Scaling Benchmark
+ *
+ * DESCRIPTION:  First checks ConcurrentHashTable under racing writers and
+ *               readers: every finished insert must stay visible, a code
+ *               inserted by two writers at once must be added exactly once,
+ *               and no reader may see a half-built course. Then measures
+ *               lookup throughput from 1 to MAX_THREADS reader threads while
+ *               one writer inserts new courses the whole time, next to the
+ *               single-threaded HashTable as a baseline.
+ *
+ * BUILD:        g++ -std=c++17 -O2 -pthread -o ConcurrentHashTableBench \
+ *                   ConcurrentHashTableBench.cpp -lsqlite3
+ *
+ * USAGE:        ConcurrentHashTableBench [PRELOAD] [SECONDS] [MAX_THREADS]
+ * =============================================================================
+ */
+
+
+
+
+// ============================================================================
+// IMPORTS
+// ----------------------------------------------------------------------------
+#define ADVISING_ASSISTANT_NO_MAIN
+#include "../enhancement3/AdvisingAssistant.cpp"
+#include <iomanip>          // Fixed-width result table.
+// ============================================================================
+
+
+
+// ============================================================================
+// BENCHMARK: Synthetic Courses
+// ----------------------------------------------------------------------------
+
+// Code for key i. Title and prerequisites are derived from the code, so a
+// reader can check a course it finds no matter which writer stored it.
+string codeFor(size_t i) { return "CS" + to_string(i); }
+string titleFor(string_view code) { return "Course " + string(code); }
+vector<string> prereqsFor(size_t i) {
+    return i < 2 ? vector<string>() : vector<string>{ codeFor(i / 2), codeFor(i - 1) };
+}
+
+bool courseIsWhole(const SharedNode* node, size_t i) {
+    vector<string> expected = prereqsFor(i);
+    if (node->title != titleFor(node->key) || node->prereqs.size() != expected.size()) return false;
+    for (size_t k = 0; k < expected.size(); ++k) {
+        if (node->prereqs[k] != expected[k]) return false;
+    }
+    return true;
+}
+// ============================================================================
+
+
+
+// ============================================================================
+// BENCHMARK: Stress Test
+// ----------------------------------------------------------------------------
+
+// Writer w owns keys w, w + W, w + 2W, ... and publishes how many of them
+// are stored; it then races writer w + 1 for that writer's keys. Readers
+// only look up keys behind some writer's published count, plus keys never
+// inserted. Returns the first broken invariant, or an empty string.
+string runStress(size_t keys, size_t writers, size_t readers) {
+    ConcurrentHashTable table;
+    vector<string> codes(keys), titles(keys);
+    vector<vector<string>> prereqs(keys);
+    for (size_t i = 0; i < keys; ++i) {
+        codes[i] = codeFor(i);
+        titles[i] = titleFor(codes[i]);
+        prereqs[i] = prereqsFor(i);
+    }
+
+    unique_ptr<atomic<size_t>[]> progress(new atomic<size_t>[writers]);
+    unique_ptr<atomic<uint32_t>[]> wins(new atomic<uint32_t>[keys]);
+    for (size_t w = 0; w < writers; ++w) progress[w].store(0);
+    for (size_t i = 0; i < keys; ++i) wins[i].store(0);
+    atomic<size_t> writersDone{ 0 };
+    mutex failureLock;
+    string failure;
+    auto fail = [&](const string& message) {
+        lock_guard<mutex> guard(failureLock);
+        if (failure.empty()) failure = message;
+    };
+
+    vector<thread> threads;
+    for (size_t w = 0; w < writers; ++w) {
+        threads.emplace_back([&, w] {
+            size_t owned = 0;
+            for (size_t i = w; i < keys; i += writers) {
+                if (table.insertRecord(codes[i], titles[i], prereqs[i])) wins[i].fetch_add(1);
+                progress[w].store(++owned, memory_order_release);
+            }
+            for (size_t i = (w + 1) % writers; i < keys; i += writers) {
+                if (table.insertRecord(codes[i], titles[i], prereqs[i])) wins[i].fetch_add(1);
+            }
+            writersDone.fetch_add(1);
+        });
+    }
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            uint64_t state = 0x9E3779B97F4A7C15ull * (r + 1);
+            char missCode[32];
+            while (writersDone.load() < writers) {
+                state ^= state << 13; state ^= state >> 7; state ^= state << 17;
+                size_t w = state % writers;
+                size_t stored = progress[w].load(memory_order_acquire);
+                if (stored == 0) continue;
+                size_t i = w + (state >> 20) % stored * writers;
+
+                string lower = codes[i];
+                lower[0] = 'c';
+                const SharedNode* node = table.findCourse(lower);
+                if (node == nullptr) return fail("stored course " + codes[i] + " not found");
+                if (node->key != codes[i] || !courseIsWhole(node, i)) {
+                    return fail("course " + codes[i] + " read half-built or wrong");
+                }
+
+                int length = snprintf(missCode, sizeof(missCode), "CS%zu", keys + i);
+                if (table.findCourse(string_view(missCode, length)) != nullptr) {
+                    return fail(string("never-inserted course ") + missCode + " found");
+                }
+            }
+        });
+    }
+    for (thread& t : threads) t.join();
+    if (!failure.empty()) return failure;
+
+    if (table.size() != keys) {
+        return "size is " + to_string(table.size()) + ", expected " + to_string(keys);
+    }
+    for (size_t i = 0; i < keys; ++i) {
+        if (wins[i].load() != 1) return codes[i] + " added " + to_string(wins[i].load()) + " times";
+        const SharedNode* node = table.findCourse(codes[i]);
+        if (node == nullptr || !courseIsWhole(node, i)) return codes[i] + " missing after join";
+    }
+    vector<string> sorted = codes;
+    sort(sorted.begin(), sorted.end());
+    if (table.getSortedCourseCodes() != sorted) return "sorted listing differs from inserted codes";
+    return "";
+}
+// ============================================================================
+
+
+
+// ============================================================================
+// BENCHMARK: Read Scaling
+// ----------------------------------------------------------------------------
+
+struct ScalingResult {
+    double lookupsPerSecond = 0;
+    double insertsPerSecond = 0;
+    bool allFound = true;
+};
+
+// Looks up codes round-robin from a per-thread offset until stop is set.
+// Returns lookups made; clears allFound if a preloaded code was missed.
+template <typename Table>
+size_t lookupLoop(const Table& table, const vector<string>& codes, size_t offset,
+                  const atomic<bool>& stop, atomic<bool>& allFound) {
+    size_t lookups = 0, found = 0;
+    size_t i = offset % codes.size();
+    while (!stop.load(memory_order_relaxed)) {
+        for (size_t k = 0; k < 1024; ++k) {
+            found += table.findCourse(codes[i]) != nullptr;
+            if (++i == codes.size()) i = 0;
+        }
+        lookups += 1024;
+    }
+    if (found != lookups) allFound.store(false);
+    return lookups;
+}
+
+// Fresh preloaded table per run, so the writer's inserts from one run do
+// not slow lookups (or fill memory) in the next.
+ScalingResult measureReaders(const vector<string>& codes, size_t readers, double seconds) {
+    ConcurrentHashTable table;
+    const vector<string_view> noPrereqs;
+    for (const string& code : codes) table.insertRecord(code, "Preloaded course", noPrereqs);
+
+    atomic<bool> stop{ false }, allFound{ true };
+    atomic<size_t> lookups{ 0 }, inserts{ 0 };
+    vector<thread> threads;
+    threads.emplace_back([&] {
+        char code[32];
+        const vector<string_view> prereqs = { codes[0], codes[1] };
+        size_t added = 0;
+        while (!stop.load(memory_order_relaxed)) {
+            int length = snprintf(code, sizeof(code), "NEW%zu", added);
+            table.insertRecord(string_view(code, length), "Inserted while reading", prereqs);
+            ++added;
+        }
+        inserts.store(added);
+    });
+    for (size_t r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            lookups.fetch_add(lookupLoop(table, codes, r * codes.size() / readers, stop, allFound));
+        });
+    }
+    this_thread::sleep_for(chrono::duration<double>(seconds));
+    stop.store(true);
+    for (thread& t : threads) t.join();
+
+    ScalingResult result;
+    result.lookupsPerSecond = lookups.load() / seconds;
+    result.insertsPerSecond = inserts.load() / seconds;
+    result.allFound = allFound.load();
+    return result;
+}
+
+// The unsynchronized table with one reader and no writer, for reference.
+// HashTable only answers lookups after a load, so the codes go through a
+// scratch CSV file.
+double measureBaseline(const vector<string>& codes, double seconds) {
+    const string path = "ConcurrentHashTableBench.tmp.csv";
+    {
+        ofstream out(path, ios::binary);
+        for (const string& code : codes) out << code << ",Preloaded course\n";
+        if (!out) throw runtime_error("Cannot write " + path);
+    }
+    HashTable table;
+    try {
+        table.loadCsv(path);
+    }
+    catch (...) {
+        remove(path.c_str());
+        throw;
+    }
+    remove(path.c_str());
+
+    atomic<bool> stop{ false }, allFound{ true };
+    size_t lookups = 0;
+    thread reader([&] { lookups = lookupLoop(table, codes, 0, stop, allFound); });
+    this_thread::sleep_for(chrono::duration<double>(seconds));
+    stop.store(true);
+    reader.join();
+    return lookups / seconds;
+}
+// ============================================================================
+
+
+
+int main(int argc, char* argv[]) {
+    size_t preload = argc > 1 ? stoul(argv[1]) : 1000000;
+    double seconds = argc > 2 ? stod(argv[2]) : 0.5;
+    size_t maxThreads = argc > 3 ? stoul(argv[3]) : 64;
+
+    try {
+        cout << "Stress: 4 writers, 4 readers, 200000 codes ... " << flush;
+        string failure = runStress(200000, 4, 4);
+        if (!failure.empty()) {
+            cout << "FAILED: " << failure << endl;
+            return 1;
+        }
+        cout << "ok" << endl;
+
+        vector<string> codes(max<size_t>(preload, 2));
+        for (size_t i = 0; i < codes.size(); ++i) codes[i] = codeFor(i);
+
+        cout << "\nPreloaded " << codes.size() << " courses; " << thread::hardware_concurrency()
+             << " hardware threads\n";
+        double baseline = measureBaseline(codes, seconds);
+        cout << "HashTable, 1 reader, no writer: " << fixed << setprecision(1)
+             << baseline / 1e6 << " M lookups/s\n\n";
+
+        cout << right << setw(8) << "readers" << setw(16) << "M lookups/s" << setw(16) << "per reader"
+             << setw(10) << "scaling" << setw(16) << "M inserts/s" << endl;
+        double single = 0;
+        for (size_t readers = 1; readers <= maxThreads; readers *= 2) {
+            ScalingResult result = measureReaders(codes, readers, seconds);
+            if (readers == 1) single = result.lookupsPerSecond;
+            cout << setw(8) << readers << fixed
+                 << setw(16) << setprecision(1) << result.lookupsPerSecond / 1e6
+                 << setw(16) << setprecision(2) << result.lookupsPerSecond / readers / 1e6
+                 << setw(9) << setprecision(2) << result.lookupsPerSecond / single << "x"
+                 << setw(16) << setprecision(2) << result.insertsPerSecond / 1e6 << endl;
+            if (!result.allFound) {
+                cout << "MISMATCH: a preloaded course was not found with " << readers << " readers" << endl;
+                return 1;
+            }
+        }
+    }
+    catch (const exception& e) {
+        cout << "SYSTEM ERROR: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+// ============================================================================
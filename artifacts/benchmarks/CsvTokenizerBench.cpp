@@ -0,0 +1,153 @@
+/* =============================================================================
+ * PROJECT:      ABCU Advising Assistant
+ * TOOL:         CSV Tokenizer Microbenchmark
+ *
+ * DESCRIPTION:  Compares the original getline + stringstream course parser
+ *               with the SIMD delimiter scanner behind HashTable::loadCsv,
+ *               once per scan kernel this CPU supports. Input is read into
+ *               memory first, so only tokenizing is timed.
+ *
+ * BUILD:        g++ -std=c++17 -O2 -pthread -o CsvTokenizerBench \
+ *                   CsvTokenizerBench.cpp -lsqlite3
+ *
+ * USAGE:        CsvTokenizerBench [CATALOG.csv] [MIN_SECONDS]
+ * =============================================================================
+ */
+
+
+
+
+// ============================================================================
+// IMPORTS
+// ----------------------------------------------------------------------------
+#define ADVISING_ASSISTANT_NO_MAIN
+#include "../enhancement3/AdvisingAssistant.cpp"
+#include <iomanip>          // Fixed-width result table.
+// ============================================================================
+
+
+
+// ============================================================================
+// BENCHMARK: Parsers Under Test
+// ----------------------------------------------------------------------------
+
+// Totals every parser must agree on, so a fast but wrong kernel is caught.
+struct ParseTotals {
+    size_t records = 0;
+    size_t fields = 0;
+    size_t bytes = 0;
+
+    bool operator==(const ParseTotals& other) const {
+        return records == other.records && fields == other.fields && bytes == other.bytes;
+    }
+};
+
+// The enhancement 1/2 parser: getline per line, then a stringstream per line
+// split on commas into owned strings.
+ParseTotals parseWithStringstream(const string& text) {
+    ParseTotals totals;
+    istringstream file(text);
+    string line;
+    while (getline(file, line)) {
+        if (!line.empty() && line.back() == '\r') line.pop_back();
+        stringstream ss(line);
+        string field;
+        ++totals.records;
+        while (getline(ss, field, ',')) {
+            ++totals.fields;
+            totals.bytes += field.size();
+        }
+    }
+    return totals;
+}
+
+// The loadCsv path: views into the buffer, no per-field allocation.
+ParseTotals parseWithTokenizer(string_view text, ScanKernel kernel) {
+    ParseTotals totals;
+    CsvTokenizer tokenizer(text, kernel);
+    vector<string_view> fields;
+    while (tokenizer.nextRecord(fields)) {
+        ++totals.records;
+        // getline never yields a trailing empty field; count the same way.
+        size_t count = fields.back().empty() ? fields.size() - 1 : fields.size();
+        for (size_t i = 0; i < count; ++i) {
+            ++totals.fields;
+            totals.bytes += fields[i].size();
+        }
+    }
+    return totals;
+}
+// ============================================================================
+
+
+
+// ============================================================================
+// BENCHMARK: Timing Harness
+// ----------------------------------------------------------------------------
+
+// Runs parse repeatedly until minSeconds have passed; returns seconds per run.
+template <typename Parse>
+double timeParser(Parse parse, double minSeconds, ParseTotals& totals) {
+    size_t runs = 0;
+    auto start = chrono::steady_clock::now();
+    double elapsed = 0;
+    do {
+        totals = parse();
+        ++runs;
+        elapsed = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    } while (elapsed < minSeconds);
+    return elapsed / runs;
+}
+
+void printRow(const string& name, double seconds, const ParseTotals& totals, size_t inputBytes,
+              double baseline) {
+    cout << left << setw(14) << name << right << fixed
+         << setw(12) << setprecision(1) << inputBytes / seconds / 1e6
+         << setw(14) << setprecision(1) << seconds * 1e9 / max<size_t>(totals.records, 1)
+         << setw(10) << setprecision(2) << baseline / seconds << "x" << endl;
+}
+// ============================================================================
+
+
+
+int main(int argc, char* argv[]) {
+    string path = argc > 1 ? argv[1] : "../enhancement3/Program_Input.csv";
+    double minSeconds = argc > 2 ? stod(argv[2]) : 0.5;
+
+    try {
+        MappedFile file(path);
+        string_view text = file.contents();
+        string owned(text);
+
+        cout << "Input: " << path << " (" << text.size() << " bytes)\n";
+        cout << "Best kernel on this CPU: " << scanKernelName(bestScanKernel()) << "\n\n";
+        cout << left << setw(14) << "parser" << right << setw(12) << "MB/s"
+             << setw(14) << "ns/record" << setw(11) << "speedup" << endl;
+
+        ParseTotals expected;
+        double baseline = timeParser([&] { return parseWithStringstream(owned); }, minSeconds, expected);
+        printRow("stringstream", baseline, expected, text.size(), baseline);
+
+        for (ScanKernel kernel : { ScanKernel::Scalar, ScanKernel::Sse2, ScanKernel::Avx2 }) {
+            if (!scanKernelAvailable(kernel)) {
+                cout << left << setw(14) << scanKernelName(kernel) << "unavailable" << endl;
+                continue;
+            }
+            ParseTotals totals;
+            double seconds = timeParser([&] { return parseWithTokenizer(text, kernel); }, minSeconds, totals);
+            printRow(scanKernelName(kernel), seconds, totals, text.size(), baseline);
+            if (!(totals == expected)) {
+                cout << "MISMATCH: " << scanKernelName(kernel) << " saw " << totals.records
+                     << " records / " << totals.fields << " fields, expected " << expected.records
+                     << " / " << expected.fields << endl;
+                return 1;
+            }
+        }
+    }
+    catch (const exception& e) {
+        cout << "SYSTEM ERROR: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+// ============================================================================
@@ -0,0 +1,133 @@
+/* =============================================================================
+ * PROJECT:      ABCU Advising Assistant
+ * TOOL:         Query Server Regression Check
+ *
+ * DESCRIPTION:  Runs a QueryServer in-process and checks that a client which
+ *               half-closes its socket (as --connect --batch does) while a
+ *               large reply is still pending costs the event loop no CPU:
+ *               the loop must sleep until the client drains the reply, and
+ *               the reply must still arrive whole.
+ *
+ * BUILD:        g++ -std=c++17 -O2 -pthread -o QueryServerCheck \
+ *                   QueryServerCheck.cpp -lsqlite3
+ *
+ * USAGE:        QueryServerCheck [COURSES] [SECONDS]
+ * =============================================================================
+ */
+
+
+
+
+// ============================================================================
+// IMPORTS
+// ----------------------------------------------------------------------------
+#define ADVISING_ASSISTANT_NO_MAIN
+#include "../enhancement3/AdvisingAssistant.cpp"
+#include <ctime>            // Per-thread CPU clock of the event loop.
+// ============================================================================
+
+
+
+// ============================================================================
+// CHECK: Half-Closed Client
+// ----------------------------------------------------------------------------
+
+// Event-loop CPU allowed per second of idle waiting.
+const double MAX_IDLE_CPU_SHARE = 0.05;
+
+double threadCpuSeconds(thread& t) {
+    clockid_t clock;
+    timespec now;
+    if (pthread_getcpuclockid(t.native_handle(), &clock) != 0 || clock_gettime(clock, &now) != 0) {
+        throw runtime_error("Cannot read thread CPU clock.");
+    }
+    return now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Publishes a catalog big enough that "list" overflows the socket buffer.
+void publishCatalog(CatalogPublisher& catalog, size_t courses) {
+    const string path = "QueryServerCheck.tmp.csv";
+    {
+        ofstream out(path, ios::binary);
+        for (size_t i = 0; i < courses; ++i) out << "CS" << i << ",Course number " << i << "\n";
+        if (!out) throw runtime_error("Cannot write " + path);
+    }
+    try {
+        catalog.publish([&](HashTable& table) { table.loadCsv(path); });
+    }
+    catch (...) {
+        remove(path.c_str());
+        throw;
+    }
+    remove(path.c_str());
+}
+
+// Returns the first failure, or an empty string.
+string runHalfCloseCheck(size_t courses, double seconds) {
+    CatalogPublisher catalog(TableEngine::Chained);
+    publishCatalog(catalog, courses);
+    Database database;
+
+    // Built before any other thread starts, so every thread inherits the
+    // server's blocked signals and SIGTERM reaches its signalfd.
+    const string socketPath = "QueryServerCheck.sock";
+    QueryServer server(catalog, database, socketPath, 2, "load");
+    thread loop([&] { server.run(); });
+
+    string failure;
+    {
+        ServerConnection client(socketPath);
+        client.send("list\n");
+        client.finishSending();
+
+        // Let the reply fill the socket buffer, then watch the idle loop.
+        this_thread::sleep_for(chrono::milliseconds(200));
+        double before = threadCpuSeconds(loop);
+        this_thread::sleep_for(chrono::duration<double>(seconds));
+        double used = threadCpuSeconds(loop) - before;
+        if (used > MAX_IDLE_CPU_SHARE * seconds) {
+            failure = "event loop used " + to_string(used) + " s CPU in " + to_string(seconds)
+                    + " s while the reply was pending";
+        }
+
+        string status = client.readLine();
+        size_t lines = 0;
+        if (status == "ok " + to_string(courses)) {
+            while (lines < courses) {
+                client.readLine();
+                ++lines;
+            }
+        }
+        string rest;
+        if (failure.empty() && lines != courses) failure = "reply was \"" + status + "\"";
+        else if (failure.empty() && client.receive(rest)) failure = "server kept the connection open";
+    }
+
+    kill(getpid(), SIGTERM);
+    loop.join();
+    return failure;
+}
+// ============================================================================
+
+
+
+int main(int argc, char* argv[]) {
+    size_t courses = argc > 1 ? stoul(argv[1]) : 200000;
+    double seconds = argc > 2 ? stod(argv[2]) : 1.0;
+
+    try {
+        cout << "Half-closed client, " << courses << "-course reply pending ... " << flush;
+        string failure = runHalfCloseCheck(courses, seconds);
+        if (!failure.empty()) {
+            cout << "FAILED: " << failure << endl;
+            return 1;
+        }
+        cout << "ok" << endl;
+    }
+    catch (const exception& e) {
+        cout << "SYSTEM ERROR: " << e.what() << endl;
+        return 1;
+    }
+    return 0;
+}
+// ============================================================================
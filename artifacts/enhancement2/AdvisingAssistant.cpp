@@ -37,6 +37,22 @@ using namespace std;
 // UPGRADE: Uses  prime table size, reduces likelihood of hash collisions.
 const int HASH_TABLE_SIZE = 17;
 
+// Table grows through these primes (each roughly double the last)
+// so chains stay short as the catalog gets larger.
+const size_t BUCKET_PRIMES[] = {
+    HASH_TABLE_SIZE, 37, 79, 163, 331, 673, 1361, 2729, 5471, 10949, 21911,
+    43853, 87719, 175447, 350899, 701819, 1403641, 2807303, 5614657, 11229331,
+    22458671, 44917381, 89834777, 179669557, 359339171, 718678369, 1437356741
+};
+const size_t BUCKET_PRIME_COUNT = sizeof(BUCKET_PRIMES) / sizeof(BUCKET_PRIMES[0]);
+
+// Average chain length that triggers growth to the next prime.
+const double MAX_LOAD_FACTOR = 0.75;
+
+// Old buckets moved per insert while resizing. Two per insert always
+// finishes before the grown table reaches its own threshold.
+const size_t REHASH_STEP = 2;
+
 class Course {
 private:
     // Private members enforce data integrity.
@@ -98,7 +114,16 @@ class HashTable {
 private:
     // UPGRADE: Uses manual array of pointers acting as hash buckets.
     // Each index represents start of a linked list (collision chain).
-    Node* table[HASH_TABLE_SIZE];
+    vector<Node*> table;
+
+    // Previous buckets still being moved into table after a grow.
+    // Spreads rehashing across inserts so no single insert stalls.
+    vector<Node*> oldTable;
+    size_t migrateIndex = 0;
+
+    // Position in BUCKET_PRIMES and number of stored nodes.
+    size_t primeIndex = 0;
+    size_t courseCount = 0;
 
     // Stores course codes to support sorted output
     // without requiring traversal of entire hash table.
@@ -111,12 +136,13 @@ private:
     // Uses polynomial rolling hash with prime multiplier (31)
     // Reduces collisions and evenly distribute keys.
     // Average-case lookup remains O(1).
+    // Returns full value; callers constrain it to the current table size.
     unsigned int hash(const string& key) const {
         unsigned int hashVal = 0;
         for (char ch : key) {
             hashVal = hashVal * 31 + ch; // Polynomial accumulation
         }
-        return hashVal % HASH_TABLE_SIZE; // Constrain index to table size
+        return hashVal;
     }
 
     // Normalizes input to uppercase to ensure consistent hashing
@@ -149,21 +175,132 @@ private:
         return Course(code, title, prereqs);
     }
 
+    // Deletes every node in a bucket array and empties it.
+    static void deleteChains(vector<Node*>& buckets) {
+        for (Node*& head : buckets) {
+            Node* curr = head;
+            while (curr != nullptr) {
+                Node* next = curr->next;
+                delete curr;
+                curr = next;
+            }
+            head = nullptr;
+        }
+    }
+
+    // Moves up to 'steps' old buckets into the grown table.
+    // Old nodes go in front of newer ones, so first-inserted
+    // course still wins lookups when codes are duplicated.
+    void migrateBuckets(size_t steps) {
+        while (steps-- > 0 && migrateIndex < oldTable.size()) {
+            // Reverse old chain so head insertion restores its order.
+            Node* reversed = nullptr;
+            Node* curr = oldTable[migrateIndex];
+            while (curr != nullptr) {
+                Node* next = curr->next;
+                curr->next = reversed;
+                reversed = curr;
+                curr = next;
+            }
+            while (reversed != nullptr) {
+                Node* next = reversed->next;
+                size_t index = hash(toUpper(reversed->course.getCode())) % table.size();
+                reversed->next = table[index];
+                table[index] = reversed;
+                reversed = next;
+            }
+            oldTable[migrateIndex++] = nullptr;
+        }
+        if (!oldTable.empty() && migrateIndex == oldTable.size()) {
+            oldTable.clear();
+            oldTable.shrink_to_fit();
+            migrateIndex = 0;
+        }
+    }
+
+    // Starts growing to next prime once load factor threshold is crossed.
+    // Existing chains are moved a few buckets at a time by later inserts.
+    void growIfNeeded() {
+        if (courseCount + 1 <= MAX_LOAD_FACTOR * table.size()) {
+            return;
+        }
+        if (primeIndex + 1 >= BUCKET_PRIME_COUNT) {
+            return;
+        }
+
+        // Finishes any earlier resize so at most two bucket arrays exist.
+        migrateBuckets(oldTable.size());
+
+        oldTable.swap(table);
+        table.assign(BUCKET_PRIMES[++primeIndex], nullptr);
+        migrateIndex = 0;
+    }
+
+    // Searches one chain for an upper-cased key.
+    Node* findInChain(Node* curr, const string& key) const {
+        while (curr != nullptr) {
+            if (toUpper(curr->course.getCode()) == key) {
+                return curr;
+            }
+            curr = curr->next;
+        }
+        return nullptr;
+    }
+
+    // Finds key during or outside a resize. Old buckets not yet moved
+    // hold only nodes older than the new table, so search them first.
+    Node* findNode(const string& key) const {
+        unsigned int hashVal = hash(key);
+        if (!oldTable.empty()) {
+            size_t oldIndex = hashVal % oldTable.size();
+            if (oldIndex >= migrateIndex) {
+                Node* found = findInChain(oldTable[oldIndex], key);
+                if (found != nullptr) {
+                    return found;
+                }
+            }
+        }
+        return findInChain(table[hashVal % table.size()], key);
+    }
+
 public:
     // UPGRADE yses constructor to initialize hash buckets to nullptr.
     // Prevents undefined behavior during insertion or lookup.
-    HashTable() {
-        for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
-            table[i] = nullptr;
-        }
+    HashTable() : table(BUCKET_PRIMES[0], nullptr) {}
+
+    // Releases all dynamically allocated nodes to prevent memory leaks.
+    ~HashTable() {
+        deleteChains(table);
+        deleteChains(oldTable);
+    }
+
+    // Copying would double-delete nodes.
+    HashTable(const HashTable&) = delete;
+    HashTable& operator=(const HashTable&) = delete;
+
+    // Deletes all nodes and resets hash table state.
+    // Called on every reload so old nodes are not leaked.
+    void clearTable() {
+        deleteChains(table);
+        deleteChains(oldTable);
+        courseOrder.clear();
+        oldTable.clear();
+        migrateIndex = 0;
+        primeIndex = 0;
+        courseCount = 0;
+        table.assign(BUCKET_PRIMES[0], nullptr);
     }
 
     // UPGRADE INSERTION ALGORITHM: 
     // Calculates hash index and appends course the end
     // of chain, preservs existing entries, prevents data loss.
+    // Resizing is incremental: each insert also moves a few old buckets.
     void insert(Course course) {
+        migrateBuckets(REHASH_STEP);
+        growIfNeeded();
+
         string key = toUpper(course.getCode());
-        unsigned int index = hash(key);
+        size_t index = hash(key) % table.size();
         Node* newNode = new Node(course);
 
         // If no collision, insert directly.
@@ -181,6 +318,7 @@ public:
 
         // Track insertion order separately for sorted output.
         courseOrder.push_back(key);
+        ++courseCount;
     }
 
     // Loads course data from CSV file, populates hash table.
@@ -192,10 +330,7 @@ public:
         }
 
         // Reset state before loading new data.
-        courseOrder.clear();
-        for (int i = 0; i < HASH_TABLE_SIZE; ++i) {
-            table[i] = nullptr;
-        }
+        clearTable();
 
         string line;
         int lineNum = 0;
@@ -225,15 +360,9 @@ public:
             throw runtime_error("No data loaded.");
         }
 
-        string key = toUpper(code);
-        unsigned int index = hash(key);
-
-        Node* curr = table[index];
-        while (curr != nullptr) {
-            if (toUpper(curr->course.getCode()) == key) {
-                return curr->course;
-            }
-            curr = curr->next;
+        Node* found = findNode(toUpper(code));
+        if (found != nullptr) {
+            return found->course;
         }
         throw runtime_error("Course not found.");
     }
@@ -249,6 +378,16 @@ public:
         sort(courseOrder.begin(), courseOrder.end());
         return courseOrder;
     }
+
+    // Current number of hash buckets (grows through BUCKET_PRIMES).
+    size_t bucketCount() const {
+        return table.size();
+    }
+
+    // Average chain length: stored courses per active bucket.
+    double loadFactor() const {
+        return static_cast<double>(courseCount) / table.size();
+    }
 };
 // ============================================================================
 
@@ -302,6 +441,8 @@ int main() {
                 // Logic layer loads data; any errors throw exceptions handled below.
                 hashTable.loadData(filename);
                 cout << "Success: Data loaded from " << filename << endl;
+                cout << hashTable.bucketCount() << " buckets, load factor "
+                     << hashTable.loadFactor() << endl;
             }
             // Print sorted course list.
             else if (userInput == "2") {